@@ -0,0 +1,189 @@
+﻿#include "modern_enum.h"
+#include "modern_enum_histogram.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// This file contains throughput benchmarks for the runtime (non-constexpr) parts of the library.
+// Build it in Release: debug builds are not representative.
+MODERN_ENUM(Week, Monday, Tuesday, Wednesday, Thursday, Friday, Saturday, Sunday);
+
+// Names sharing a long prefix and suffix, which only differ by a few digits in the middle.
+MODERN_ENUM(
+    ErrorCode,
+    ErrorCode00Failure, ErrorCode01Failure, ErrorCode02Failure, ErrorCode03Failure, ErrorCode04Failure,
+    ErrorCode05Failure, ErrorCode06Failure, ErrorCode07Failure, ErrorCode08Failure, ErrorCode09Failure,
+    ErrorCode10Failure, ErrorCode11Failure, ErrorCode12Failure, ErrorCode13Failure, ErrorCode14Failure,
+    ErrorCode15Failure, ErrorCode16Failure, ErrorCode17Failure, ErrorCode18Failure, ErrorCode19Failure,
+    ErrorCode20Failure, ErrorCode21Failure, ErrorCode22Failure, ErrorCode23Failure, ErrorCode24Failure,
+    ErrorCode25Failure, ErrorCode26Failure, ErrorCode27Failure, ErrorCode28Failure, ErrorCode29Failure,
+    ErrorCode30Failure, ErrorCode31Failure, ErrorCode32Failure, ErrorCode33Failure, ErrorCode34Failure,
+    ErrorCode35Failure, ErrorCode36Failure, ErrorCode37Failure, ErrorCode38Failure, ErrorCode39Failure,
+    ErrorCode40Failure, ErrorCode41Failure, ErrorCode42Failure, ErrorCode43Failure, ErrorCode44Failure,
+    ErrorCode45Failure, ErrorCode46Failure, ErrorCode47Failure, ErrorCode48Failure, ErrorCode49Failure,
+    ErrorCode50Failure, ErrorCode51Failure, ErrorCode52Failure, ErrorCode53Failure, ErrorCode54Failure,
+    ErrorCode55Failure, ErrorCode56Failure, ErrorCode57Failure, ErrorCode58Failure, ErrorCode59Failure,
+    ErrorCode60Failure, ErrorCode61Failure, ErrorCode62Failure, ErrorCode63Failure, ErrorCode64Failure,
+    ErrorCode65Failure, ErrorCode66Failure, ErrorCode67Failure, ErrorCode68Failure, ErrorCode69Failure,
+    ErrorCode70Failure, ErrorCode71Failure, ErrorCode72Failure, ErrorCode73Failure, ErrorCode74Failure,
+    ErrorCode75Failure, ErrorCode76Failure, ErrorCode77Failure, ErrorCode78Failure, ErrorCode79Failure,
+    ErrorCode80Failure, ErrorCode81Failure, ErrorCode82Failure, ErrorCode83Failure, ErrorCode84Failure,
+    ErrorCode85Failure, ErrorCode86Failure, ErrorCode87Failure, ErrorCode88Failure, ErrorCode89Failure,
+    ErrorCode90Failure, ErrorCode91Failure, ErrorCode92Failure, ErrorCode93Failure, ErrorCode94Failure,
+    ErrorCode95Failure, ErrorCode96Failure, ErrorCode97Failure, ErrorCode98Failure, ErrorCode99Failure);
+
+MODERN_ENUM(
+    LongEnum,
+    e000, e001, e002, e003, e004, e005, e006, e007, e008, e009,
+    e010, e011, e012, e013, e014, e015, e016, e017, e018, e019,
+    e020, e021, e022, e023, e024, e025, e026, e027, e028, e029,
+    e030, e031, e032, e033, e034, e035, e036, e037, e038, e039,
+    e040, e041, e042, e043, e044, e045, e046, e047, e048, e049,
+    e050, e051, e052, e053, e054, e055, e056, e057, e058, e059,
+    e060, e061, e062, e063, e064, e065, e066, e067, e068, e069,
+    e070, e071, e072, e073, e074, e075, e076, e077, e078, e079,
+    e080, e081, e082, e083, e084, e085, e086, e087, e088, e089,
+    e090, e091, e092, e093, e094, e095, e096, e097, e098, e099,
+    e100, e101, e102, e103, e104, e105, e106, e107, e108, e109,
+    e110, e111, e112, e113, e114, e115, e116, e117, e118, e119,
+    e120, e121, e122, e123, e124, e125, e126, e127, e128, e129,
+    e130, e131, e132, e133, e134, e135, e136, e137, e138, e139,
+    e140, e141, e142, e143, e144, e145, e146, e147, e148, e149,
+    e150, e151, e152, e153, e154, e155, e156, e157, e158, e159,
+    e160, e161, e162, e163, e164, e165, e166, e167, e168, e169,
+    e170, e171, e172, e173, e174, e175, e176, e177, e178, e179,
+    e180, e181, e182, e183, e184, e185, e186, e187, e188, e189,
+    e190, e191, e192, e193, e194, e195, e196, e197, e198);
+
+namespace
+{
+    constexpr uint32_t s_rowCount = 10'000'000;
+    constexpr uint32_t s_repetitions = 5;
+
+    // Results are also compared against a naive implementation: the executable returns non-zero on any mismatch.
+    uint32_t s_mismatchCount = 0;
+
+    void ReportMismatch(std::string_view label)
+    {
+        std::cerr << label << " mismatch!\n";
+        s_mismatchCount++;
+    }
+
+    // Runs func several times and prints the best throughput, in GB/s of processed input.
+    template <class Func>
+    void Measure(const std::string& label, size_t bytes, Func&& func)
+    {
+        double bestSeconds = 1e9;
+        for (uint32_t i = 0; i < s_repetitions; i++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            func();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            bestSeconds = std::min(bestSeconds, elapsed.count());
+        }
+        std::cout << label << ": " << bytes / bestSeconds / 1e9 << " GB/s\n";
+    }
+
+    template <class Enum>
+    std::vector<Enum> MakeRandomElements(uint32_t count)
+    {
+        std::mt19937 rng{ 42 };
+        std::uniform_int_distribution<uint32_t> dist{ 0, Enum::GetCount() - 1 };
+        std::vector<Enum> elements(count);
+        for (Enum& e : elements) e = Enum::FromIndex(dist(rng));
+        return elements;
+    }
+
+    template <class Enum>
+    void ParseColumn_Benchmark()
+    {
+        std::string column;
+        for (Enum e : MakeRandomElements<Enum>(s_rowCount))
+        {
+            column += e.toString();
+            column += '\n';
+        }
+
+        std::vector<Enum> parsed(s_rowCount);
+        uint32_t errorCount = 0;
+
+        Measure(std::string(Enum::GetName()) + "::FromString per row", column.size(), [&] {
+            uint32_t row = 0;
+            for (size_t begin = 0, end; begin < column.size(); begin = end + 1)
+            {
+                end = column.find('\n', begin);
+                parsed[row++] = Enum::FromString(std::string_view(column).substr(begin, end - begin));
+            }
+        });
+
+        const std::vector<Enum> expected = parsed;
+
+        Measure(std::string(Enum::GetName()) + "::ParseColumn", column.size(), [&] {
+            Enum::ParseColumn(column, '\n', parsed.data(), [&](uint32_t, std::string_view) { errorCount++; });
+        });
+
+        if (errorCount != 0 || parsed != expected)
+            ReportMismatch(std::string(Enum::GetName()) + "::ParseColumn");
+    }
+
+    void CheckParseColumnErrors()
+    {
+        std::vector<Week> parsed(3);
+        std::vector<uint32_t> badRows;
+        Week::ParseColumn("Monday\tFunday\tSunday\t", '\t', parsed.data(), [&](uint32_t row, std::string_view) { badRows.push_back(row); });
+        if (badRows != std::vector<uint32_t>{ 1 } || parsed[0] != Week::Monday || parsed[2] != Week::Sunday)
+            ReportMismatch("ParseColumn error reporting");
+    }
+
+    template <class Enum>
+    void Histogram_Benchmark(const std::string& label, const std::vector<Enum>& elements)
+    {
+        const size_t bytes = elements.size() * sizeof(Enum);
+
+        modern_enum::Histogram<Enum> expected;
+        Measure(label + " naive histogram", bytes, [&] {
+            expected = {};
+            for (Enum e : elements) expected[e]++;
+        });
+
+        modern_enum::Histogram<Enum> histogram;
+        Measure(label + " MakeHistogram", bytes, [&] {
+            histogram = modern_enum::MakeHistogram(elements.data(), elements.size());
+        });
+
+        modern_enum::Histogram<Enum> parallelHistogram;
+        Measure(label + " MakeHistogramParallel", bytes, [&] {
+            parallelHistogram = modern_enum::MakeHistogramParallel(elements.data(), elements.size());
+        });
+
+        for (Enum e : Enum::GetElements())
+            if (histogram[e] != expected[e] || parallelHistogram[e] != expected[e])
+                ReportMismatch(label + " histogram");
+    }
+
+    // Random values, and runs of repeated values: the latter stall a naive histogram on a single counter.
+    template <class Enum>
+    void Histogram_Benchmark()
+    {
+        std::vector<Enum> elements = MakeRandomElements<Enum>(s_rowCount);
+        Histogram_Benchmark(std::string(Enum::GetName()) + " random", elements);
+
+        for (size_t i = 0; i < elements.size(); i++)
+            elements[i] = elements[i / 1024 * 1024];
+        Histogram_Benchmark(std::string(Enum::GetName()) + " repeated", elements);
+    }
+}
+
+int main()
+{
+    CheckParseColumnErrors();
+    ParseColumn_Benchmark<Week>();
+    ParseColumn_Benchmark<LongEnum>();
+    ParseColumn_Benchmark<ErrorCode>();
+    Histogram_Benchmark<Week>();
+    Histogram_Benchmark<LongEnum>();
+    return s_mismatchCount == 0 ? 0 : 1;
+}
@@ -47,7 +47,19 @@ int main()
 
     std::cout << "\nAnd now, do I train over the weekend? " << ((weekend & gymDays).any() ? "Yes" : "No");
 
+#if MODERN_ENUM_REGISTRY_ENABLED
+    std::cout << "\nRegistered enums:";
+    modern_enum::Registry::ForEach([](const modern_enum::EnumInfo& info) {
+        std::cout << " " << info.name();
+    });
+
+    std::cout << "\nFriday's index, found by name: " << modern_enum::Registry::FindIndex("Week", "Friday").value();
+#endif
+
     std::cout << std::endl;
 
+    // Prints toString/FromString statistics, if MODERN_ENUM_INSTRUMENTATION_ENABLED is set.
+    modern_enum::Instrumentation::Dump(stdout);
+
     return 0;
 }
\ No newline at end of file
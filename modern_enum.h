@@ -1,12 +1,68 @@
 ﻿#pragma once
 #include <array>
 #include <string_view>
+#include <optional>
+#include <type_traits>
+#include <cstdio>
+#include <cstdlib>
 #include <cassert>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _MODERN_ENUM_SSE2 1
+#include <emmintrin.h>
+#else
+#define _MODERN_ENUM_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 // Both Enum and Enum::Set classes have Natvis support - otherwise they would be very hard to read during debug.
 // Supporting this requires a little extra static memory - disable this macro if you don't care about natvis.
 #define MODERN_ENUM_NATVIS_SUPPORT_ENABLED 1
 
+// Every enum can register its name and element names in a process-wide registry at static-init time,
+// so that it can be found by name at runtime (see modern_enum::Registry).
+// This costs a hash table per enum plus a dynamic initializer - define this macro to 1 to opt in.
+#ifndef MODERN_ENUM_REGISTRY_ENABLED
+#define MODERN_ENUM_REGISTRY_ENABLED 0
+#endif
+
+// Policy used by Enum::FromIndex, Enum::FromString and Set construction when none is given explicitly
+// (see modern_enum::Unchecked and modern_enum::Trapping). modern_enum::Checked changes the return type of the call,
+// so it can only be chosen per call, not as the default.
+#ifndef MODERN_ENUM_DEFAULT_CHECK_POLICY
+#define MODERN_ENUM_DEFAULT_CHECK_POLICY ::modern_enum::Unchecked
+#endif
+
+// Records per-thread counts of toString/FromString calls, FromString misses and FromString latencies for every enum,
+// to be reported by modern_enum::Instrumentation::Dump. When disabled, the hooks compile to nothing.
+// Instrumented enums are found through their registry entry, so this also populates modern_enum::Registry.
+#ifndef MODERN_ENUM_INSTRUMENTATION_ENABLED
+#define MODERN_ENUM_INSTRUMENTATION_ENABLED 0
+#endif
+
+#if MODERN_ENUM_REGISTRY_ENABLED || MODERN_ENUM_INSTRUMENTATION_ENABLED
+#include <atomic>
+#endif
+
+#if MODERN_ENUM_INSTRUMENTATION_ENABLED
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+#if defined(__clang__)
+#define _MODERN_ENUM_ASSUME(Condition) __builtin_assume(Condition)
+#elif defined(_MSC_VER)
+#define _MODERN_ENUM_ASSUME(Condition) __assume(Condition)
+#else
+#define _MODERN_ENUM_ASSUME(Condition) do { if (!(Condition)) __builtin_unreachable(); } while (false)
+#endif
+
 #define MODERN_ENUM(Enum, ...) \
     class Enum\
     {\
@@ -50,8 +106,13 @@
         constexpr static std::string_view        GetName();\
         constexpr static const EnumArray&        GetElements();\
 \
-        constexpr static Enum                    FromString(std::string_view);\
-        constexpr static Enum                    FromIndex(uint32_t);\
+        template <class Policy = MODERN_ENUM_DEFAULT_CHECK_POLICY>\
+        constexpr static internal::modern_enum::CheckResult<Policy, Enum>   FromString(std::string_view);\
+        template <class Policy = MODERN_ENUM_DEFAULT_CHECK_POLICY>\
+        constexpr static internal::modern_enum::CheckResult<Policy, Enum>   FromIndex(uint32_t);\
+\
+        template <class ErrorSink>\
+        static uint32_t                          ParseColumn(std::string_view, char, Enum*, ErrorSink&&);\
 \
         constexpr std::string_view toString() const; \
         constexpr uint32_t index() const; \
@@ -66,8 +127,68 @@
 
 
 
+namespace modern_enum
+{
+    // Invalid input is undefined behavior: asserts in debug, and is an optimization hint in release.
+    struct Unchecked {};
+
+    // Invalid input is reported by returning an empty std::optional.
+    struct Checked {};
+
+    // Invalid input aborts the program, after printing the enum name and the bad input.
+    struct Trapping {};
+
+    static_assert(std::is_same_v<MODERN_ENUM_DEFAULT_CHECK_POLICY, Unchecked> || std::is_same_v<MODERN_ENUM_DEFAULT_CHECK_POLICY, Trapping>,
+        "MODERN_ENUM_DEFAULT_CHECK_POLICY must be ::modern_enum::Unchecked or ::modern_enum::Trapping - use Checked per call");
+}
+
 namespace internal::modern_enum
 {
+    template <class Policy, class Enum>
+    using CheckResult = std::conditional_t<std::is_same_v<Policy, ::modern_enum::Checked>, std::optional<Enum>, Enum>;
+
+    [[noreturn]] inline void Trap(std::string_view className, std::string_view name)
+    {
+        std::fprintf(stderr, "modern_enum: \"%.*s\" is not an element of %.*s\n", int(name.size()), name.data(), int(className.size()), className.data());
+        std::abort();
+    }
+
+    [[noreturn]] inline void Trap(std::string_view className, uint32_t idx)
+    {
+        std::fprintf(stderr, "modern_enum: index %u is out of range for %.*s\n", idx, int(className.size()), className.data());
+        std::abort();
+    }
+
+    // Validation for code paths that cannot return an error.
+    template <class Policy, class Input>
+    constexpr void Validate(bool valid, std::string_view className, Input input)
+    {
+        if constexpr (std::is_same_v<Policy, ::modern_enum::Trapping>)
+        {
+            if (!valid) Trap(className, input);
+        }
+        else
+        {
+            assert(valid);
+            _MODERN_ENUM_ASSUME(valid);
+        }
+    }
+
+    template <class Policy, class Enum, class Input>
+    constexpr CheckResult<Policy, Enum> Check(bool valid, Enum e, std::string_view className, Input input)
+    {
+        if constexpr (std::is_same_v<Policy, ::modern_enum::Checked>)
+        {
+            if (!valid) return std::nullopt;
+        }
+        else
+        {
+            Validate<Policy>(valid, className, input);
+        }
+        return e;
+    }
+
+
     template<uint64_t BitCount>
     class BitSet
     {
@@ -193,14 +314,463 @@ namespace internal::modern_enum
     }
 
 
+    // FNV-1a, used to hash both enum names and element names.
+    // Every byte is hashed: names commonly differ only by a few characters in the middle (e.g. ErrorCode12Failure).
+    constexpr uint64_t HashName(std::string_view name)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : name)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    constexpr static uint32_t s_invalidIndex = 0xFFFFFFFF;
+
+    constexpr uint32_t FindInNameTable(const uint32_t* slots, uint32_t slotCount, const std::string_view* names, std::string_view name)
+    {
+        const uint32_t mask = slotCount - 1;
+        for (uint32_t slot = static_cast<uint32_t>(HashName(name)) & mask; slots[slot] != s_invalidIndex; slot = (slot + 1) & mask)
+            if (names[slots[slot]] == name)
+                return slots[slot];
+        return s_invalidIndex;
+    }
+
+    // Open-addressing hash table from element name to element index, built at compile time.
+    // Slot count is at least twice the element count, so probe sequences stay short.
     template <uint32_t Count>
-    constexpr static uint32_t CreateFromString(std::string_view className, std::string_view name, const std::array<std::string_view, Count>& names)
+    class NameTable
+    {
+    public:
+        constexpr NameTable(const std::array<std::string_view, Count>& names) : m_slots{}
+        {
+            for (uint32_t i = 0; i < s_slotCount; i++)
+                m_slots[i] = s_invalidIndex;
+
+            for (uint32_t i = 0; i < Count; i++)
+            {
+                uint32_t slot = static_cast<uint32_t>(HashName(names[i])) & (s_slotCount - 1);
+                while (m_slots[slot] != s_invalidIndex)
+                    slot = (slot + 1) & (s_slotCount - 1);
+                m_slots[slot] = i;
+            }
+        }
+
+        constexpr uint32_t find(std::string_view name, const std::array<std::string_view, Count>& names) const
+        {
+            return FindInNameTable(m_slots.data(), s_slotCount, names.data(), name);
+        }
+
+        constexpr const uint32_t* slots()     const { return m_slots.data(); }
+        constexpr static uint32_t slotCount()       { return s_slotCount; }
+
+    private:
+        constexpr static uint32_t MakeSlotCount()
+        {
+            uint32_t size = 1;
+            while (size < 2 * Count) size *= 2;
+            return size;
+        }
+
+        constexpr static uint32_t s_slotCount = MakeSlotCount();
+
+        std::array<uint32_t, s_slotCount> m_slots;
+    };
+
+
+    inline uint32_t CountTrailingZeros(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanForward(&idx, mask);
+        return idx;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Calls onToken(std::string_view) for every delimiter-separated token of the buffer.
+    // A trailing delimiter does not start a new token, so both "a,b" and "a,b," yield two tokens.
+    template <class OnToken>
+    void ForEachToken(std::string_view buffer, char delimiter, OnToken&& onToken)
+    {
+        const char* const end = buffer.data() + buffer.size();
+        const char* tokenBegin = buffer.data();
+        const char* p = buffer.data();
+
+#if _MODERN_ENUM_SSE2
+        // Compare 16 bytes at a time against the delimiter, then walk the set bits of the match mask.
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        for (; end - p >= 16; p += 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, delimiters)));
+            for (; mask; mask &= mask - 1)
+            {
+                const char* delimiterPos = p + CountTrailingZeros(mask);
+                onToken(std::string_view(tokenBegin, delimiterPos - tokenBegin));
+                tokenBegin = delimiterPos + 1;
+            }
+        }
+#endif
+
+        for (; p < end; p++)
+        {
+            if (*p != delimiter) continue;
+            onToken(std::string_view(tokenBegin, p - tokenBegin));
+            tokenBegin = p + 1;
+        }
+
+        if (tokenBegin != end)
+            onToken(std::string_view(tokenBegin, end - tokenBegin));
+    }
+
+
+    // Returns Count if the name is not found. Unchecked does not expect that to happen, so the loop needs no exit test.
+    template <class Policy, uint32_t Count>
+    constexpr static uint32_t CreateFromString(std::string_view name, const std::array<std::string_view, Count>& names)
     {
-        for (int i = 0; i < Count; i++) if (names[i] == name) return i;
-        assert(false);
+        for (uint32_t i = 0; i < Count; i++) if (names[i] == name) return i;
+        if constexpr (std::is_same_v<Policy, ::modern_enum::Unchecked>)
+        {
+            assert(false);
+            _MODERN_ENUM_ASSUME(false);
+        }
+        return Count;
     }
 }
 
+
+#if MODERN_ENUM_REGISTRY_ENABLED || MODERN_ENUM_INSTRUMENTATION_ENABLED
+namespace internal::modern_enum
+{
+    // Lock-free push to the front of an intrusive singly linked list whose nodes are never removed.
+    template <class Node>
+    void PushFront(std::atomic<Node*>& head, Node*& next, Node* node)
+    {
+        next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+}
+
+namespace modern_enum
+{
+    class Registry;
+
+    // Runtime reflection info of a single enum, as stored in the Registry.
+    class EnumInfo
+    {
+    public:
+        EnumInfo(std::string_view name, const std::string_view* names, uint32_t count, const uint32_t* slots, uint32_t slotCount);
+
+        EnumInfo(const EnumInfo&) = delete;
+        EnumInfo& operator=(const EnumInfo&) = delete;
+
+        std::string_view            name()  const { return m_name; }
+        uint32_t                    count() const { return m_count; }
+        // Dense index of the enum in registration order, starting from 0.
+        uint32_t                    id()    const { return m_id; }
+        std::string_view            elementName(uint32_t idx) const { assert(idx < m_count); return m_names[idx]; }
+
+        // True if another registered enum has the same unqualified name: Registry::Find does not return either of them.
+        bool                        ambiguous() const { return m_ambiguous.load(std::memory_order_acquire); }
+
+        std::optional<uint32_t>     findIndex(std::string_view elementName) const
+        {
+            const uint32_t idx = internal::modern_enum::FindInNameTable(m_slots, m_slotCount, m_names, elementName);
+            if (idx == internal::modern_enum::s_invalidIndex) return std::nullopt;
+            return idx;
+        }
+
+    private:
+        friend class Registry;
+
+        std::string_view            m_name;
+        const std::string_view*     m_names;
+        uint32_t                    m_count;
+        const uint32_t*             m_slots;
+        uint32_t                    m_slotCount;
+        uint32_t                    m_id = 0;
+
+        EnumInfo*                   m_nextInBucket = nullptr;
+        EnumInfo*                   m_nextRegistered = nullptr;
+        std::atomic<bool>           m_ambiguous { false };
+    };
+
+    // Process-wide registry of all enums, populated at static-init time when MODERN_ENUM_REGISTRY_ENABLED
+    // (or MODERN_ENUM_INSTRUMENTATION_ENABLED) is set.
+    // Entries are never removed, so readers simply walk immutable linked lists: lookups and iteration are wait-free
+    // and can run concurrently with registration.
+    // Enums are registered under their unqualified name. Names shared by several enums (e.g. in different namespaces)
+    // are ambiguous: Find returns nullptr for them, rather than an enum that would depend on static-init order.
+    class Registry
+    {
+    public:
+        static const EnumInfo* Find(std::string_view enumName)
+        {
+            const EnumInfo* info = s_buckets[internal::modern_enum::HashName(enumName) % s_bucketCount].load(std::memory_order_acquire);
+            for (; info; info = info->m_nextInBucket)
+                if (info->m_name == enumName)
+                    return info->ambiguous() ? nullptr : info;
+            return nullptr;
+        }
+
+        static std::optional<uint32_t> FindIndex(std::string_view enumName, std::string_view elementName)
+        {
+            const EnumInfo* info = Find(enumName);
+            if (!info) return std::nullopt;
+            return info->findIndex(elementName);
+        }
+
+        // Invokes func(const EnumInfo&) for every registered enum, most recently registered first.
+        template <class Func>
+        static void ForEach(Func&& func)
+        {
+            for (const EnumInfo* info = s_first.load(std::memory_order_acquire); info; info = info->m_nextRegistered)
+                func(*info);
+        }
+
+    private:
+        friend class EnumInfo;
+
+        static void Register(EnumInfo& info)
+        {
+            info.m_id = s_nextId.fetch_add(1, std::memory_order_relaxed);
+            internal::modern_enum::PushFront(s_buckets[internal::modern_enum::HashName(info.m_name) % s_bucketCount], info.m_nextInBucket, &info);
+            internal::modern_enum::PushFront(s_first, info.m_nextRegistered, &info);
+
+            // Entries pushed before this one are all reachable from it, so of two enums sharing a name,
+            // the one registered last always finds the other.
+            for (EnumInfo* other = info.m_nextInBucket; other; other = other->m_nextInBucket)
+            {
+                if (other->m_name != info.m_name) continue;
+                other->m_ambiguous.store(true, std::memory_order_release);
+                info.m_ambiguous.store(true, std::memory_order_release);
+            }
+        }
+
+        constexpr static uint32_t s_bucketCount = 256;
+
+        inline static std::atomic<EnumInfo*> s_buckets[s_bucketCount] {};
+        inline static std::atomic<EnumInfo*> s_first {};
+        inline static std::atomic<uint32_t>  s_nextId {};
+    };
+
+    inline EnumInfo::EnumInfo(std::string_view name, const std::string_view* names, uint32_t count, const uint32_t* slots, uint32_t slotCount)
+        : m_name{name}, m_names{names}, m_count{count}, m_slots{slots}, m_slotCount{slotCount}
+    {
+        Registry::Register(*this);
+    }
+}
+#endif
+
+
+#if MODERN_ENUM_INSTRUMENTATION_ENABLED
+namespace internal::modern_enum
+{
+    constexpr static uint32_t s_latencyBucketCount = 32;
+
+    // Counters of one enum in one thread. Only the owning thread writes them, so increments need no read-modify-write,
+    // but they are still atomics so that Dump can read them from another thread.
+    struct EnumCounters
+    {
+        explicit EnumCounters(uint32_t count)
+            : count{count}, toStringHits{ new std::atomic<uint64_t>[count]{} }, fromStringHits{ new std::atomic<uint64_t>[count]{} } {}
+
+        const uint32_t                                              count;
+        std::atomic<uint64_t>                                       toStringCalls {};
+        std::atomic<uint64_t>                                       fromStringCalls {};
+        std::atomic<uint64_t>                                       fromStringMisses {};
+        std::array<std::atomic<uint64_t>, s_latencyBucketCount>    fromStringLatency {};
+        std::unique_ptr<std::atomic<uint64_t>[]>                    toStringHits;
+        std::unique_ptr<std::atomic<uint64_t>[]>                    fromStringHits;
+    };
+
+    inline void Increment(std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Counters of one enum summed over several threads.
+    struct EnumTotals
+    {
+        void add(const EnumCounters& counters)
+        {
+            toStringHits.resize(counters.count);
+            fromStringHits.resize(counters.count);
+
+            toStringCalls += counters.toStringCalls.load(std::memory_order_relaxed);
+            fromStringCalls += counters.fromStringCalls.load(std::memory_order_relaxed);
+            fromStringMisses += counters.fromStringMisses.load(std::memory_order_relaxed);
+            for (uint32_t b = 0; b < s_latencyBucketCount; b++)
+                fromStringLatency[b] += counters.fromStringLatency[b].load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < counters.count; i++)
+            {
+                toStringHits[i] += counters.toStringHits[i].load(std::memory_order_relaxed);
+                fromStringHits[i] += counters.fromStringHits[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        uint64_t                                    toStringCalls = 0;
+        uint64_t                                    fromStringCalls = 0;
+        uint64_t                                    fromStringMisses = 0;
+        std::array<uint64_t, s_latencyBucketCount>  fromStringLatency {};
+        std::vector<uint64_t>                       toStringHits;
+        std::vector<uint64_t>                       fromStringHits;
+    };
+
+    // Counters of all enums used by one thread, indexed by EnumInfo::id().
+    // Each thread owns its buffer: when the thread exits, the buffer's counts are added to the retired totals and it is freed.
+    class ThreadBuffer
+    {
+    public:
+        static ThreadBuffer& Get()
+        {
+            thread_local Owner owner;
+            return *owner.buffer;
+        }
+
+        // Only the owning thread grows m_counters, under the shared mutex, so it can read it without locking.
+        EnumCounters& getCounters(const ::modern_enum::EnumInfo& e)
+        {
+            if (e.id() < m_counters.size() && m_counters[e.id()])
+                return *m_counters[e.id()];
+
+            std::lock_guard<std::mutex> lock{ GetShared().mutex };
+            if (e.id() >= m_counters.size())
+                m_counters.resize(e.id() + 1);
+            m_counters[e.id()] = std::make_unique<EnumCounters>(e.count());
+            return *m_counters[e.id()];
+        }
+
+        // Sums the counters of an enum over the live buffers and the threads that have exited.
+        static EnumTotals GetTotals(const ::modern_enum::EnumInfo& e)
+        {
+            Shared& shared = GetShared();
+            std::lock_guard<std::mutex> lock{ shared.mutex };
+
+            EnumTotals totals = e.id() < shared.retired.size() ? shared.retired[e.id()] : EnumTotals{};
+            for (const ThreadBuffer* buffer : shared.buffers)
+                if (e.id() < buffer->m_counters.size() && buffer->m_counters[e.id()])
+                    totals.add(*buffer->m_counters[e.id()]);
+            return totals;
+        }
+
+    private:
+        // Links the calling thread's buffer on first use; retires, unlinks and frees it when the thread exits.
+        struct Owner
+        {
+            Owner() : buffer{ new ThreadBuffer }
+            {
+                Shared& shared = GetShared();
+                std::lock_guard<std::mutex> lock{ shared.mutex };
+                shared.buffers.push_back(buffer);
+            }
+
+            ~Owner()
+            {
+                Shared& shared = GetShared();
+                std::lock_guard<std::mutex> lock{ shared.mutex };
+
+                for (uint32_t id = 0; id < buffer->m_counters.size(); id++)
+                {
+                    if (!buffer->m_counters[id]) continue;
+                    if (id >= shared.retired.size())
+                        shared.retired.resize(id + 1);
+                    shared.retired[id].add(*buffer->m_counters[id]);
+                }
+                shared.buffers.erase(std::find(shared.buffers.begin(), shared.buffers.end(), buffer));
+                delete buffer;
+            }
+
+            Owner(const Owner&) = delete;
+            Owner& operator=(const Owner&) = delete;
+
+            ThreadBuffer* buffer;
+        };
+
+        struct Shared
+        {
+            std::mutex                      mutex;
+            std::vector<ThreadBuffer*>      buffers;
+            std::vector<EnumTotals>         retired;
+        };
+
+        // Never destroyed, since threads can still exit during static destruction.
+        static Shared& GetShared()
+        {
+            static Shared* shared = new Shared;
+            return *shared;
+        }
+
+        std::vector<std::unique_ptr<EnumCounters>>      m_counters;
+    };
+
+    inline uint64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    inline void RecordToString(const ::modern_enum::EnumInfo& e, uint32_t idx)
+    {
+        EnumCounters& counters = ThreadBuffer::Get().getCounters(e);
+        Increment(counters.toStringCalls);
+        Increment(counters.toStringHits[idx]);
+    }
+
+    // idx is the element count on a miss. Latencies are bucketed by power of two nanoseconds.
+    inline void RecordFromString(const ::modern_enum::EnumInfo& e, uint32_t idx, uint64_t startTime)
+    {
+        uint64_t elapsed = Now() - startTime;
+        uint32_t bucket = 0;
+        for (; elapsed > 1 && bucket < s_latencyBucketCount - 1; elapsed >>= 1) bucket++;
+
+        EnumCounters& counters = ThreadBuffer::Get().getCounters(e);
+        Increment(counters.fromStringCalls);
+        Increment(counters.fromStringLatency[bucket]);
+        Increment(idx < e.count() ? counters.fromStringHits[idx] : counters.fromStringMisses);
+    }
+}
+#endif
+
+
+namespace modern_enum
+{
+    class Instrumentation
+    {
+    public:
+        // Prints the counters of every instrumented enum, summed over all threads. Does nothing if instrumentation is disabled.
+        static void Dump(std::FILE* out = stderr)
+        {
+#if MODERN_ENUM_INSTRUMENTATION_ENABLED
+            using namespace internal::modern_enum;
+
+            Registry::ForEach([&](const EnumInfo& e) {
+                const EnumTotals totals = ThreadBuffer::GetTotals(e);
+                if (totals.toStringCalls == 0 && totals.fromStringCalls == 0) return;
+
+                std::fprintf(out, "%.*s: toString %llu, FromString %llu (%llu misses)\n", int(e.name().size()), e.name().data(),
+                    (unsigned long long)totals.toStringCalls, (unsigned long long)totals.fromStringCalls, (unsigned long long)totals.fromStringMisses);
+
+                for (uint32_t b = 0; b < s_latencyBucketCount; b++)
+                    if (totals.fromStringLatency[b])
+                        std::fprintf(out, "    FromString latency < %llu ns: %llu\n", 2ull << b, (unsigned long long)totals.fromStringLatency[b]);
+
+                for (uint32_t i = 0; i < e.count(); i++)
+                    if (totals.toStringHits[i] || totals.fromStringHits[i])
+                        std::fprintf(out, "    %.*s: toString %llu, FromString %llu\n", int(e.elementName(i).size()), e.elementName(i).data(),
+                            (unsigned long long)totals.toStringHits[i], (unsigned long long)totals.fromStringHits[i]);
+            });
+#else
+            (void)out;
+#endif
+        }
+    };
+}
+
+
 // Modify the following code to increase the maximum number of elements supported:
 // 1) _MODERN_ENUM_COUNT_ELEMENTS_MACRO
 // 2) _MODERN_ENUM_COUNT_ELEMENTS
@@ -483,17 +1053,47 @@ namespace internal::modern_enum
 #endif
 
 
+#if MODERN_ENUM_INSTRUMENTATION_ENABLED
+#if defined(__cpp_lib_is_constant_evaluated)
+#define _MODERN_ENUM_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define _MODERN_ENUM_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#define _MODERN_ENUM_RECORD_TO_STRING(Index) \
+        if (!_MODERN_ENUM_IS_CONSTANT_EVALUATED()) internal::modern_enum::RecordToString(s_enumInfo, Index);
+// Not const: the initializer of a const integral variable is manifestly constant-evaluated, so it would always read 0.
+#define _MODERN_ENUM_START_TIMER(StartTime) \
+        uint64_t StartTime = _MODERN_ENUM_IS_CONSTANT_EVALUATED() ? 0 : internal::modern_enum::Now();
+#define _MODERN_ENUM_RECORD_FROM_STRING(Index, StartTime) \
+        if (!_MODERN_ENUM_IS_CONSTANT_EVALUATED()) internal::modern_enum::RecordFromString(s_enumInfo, Index, StartTime);
+#else
+#define _MODERN_ENUM_RECORD_TO_STRING(Index)
+#define _MODERN_ENUM_START_TIMER(StartTime)
+#define _MODERN_ENUM_RECORD_FROM_STRING(Index, StartTime)
+#endif
+
+
+#if MODERN_ENUM_REGISTRY_ENABLED || MODERN_ENUM_INSTRUMENTATION_ENABLED
+#define _MODERN_ENUM_REGISTRY_SUPPORT() \
+        inline static ::modern_enum::EnumInfo s_enumInfo { s_name, s_names.data(), s_count, s_nameTable.slots(), s_nameTable.slotCount() };
+#else
+#define _MODERN_ENUM_REGISTRY_SUPPORT()
+#endif
+
+
 #define _MODERN_ENUM_PRIVATE_MEMBERS(Enum, ...)\
     private:\
         constexpr Enum(uint32_t idx)  : m_idx{idx} {}\
 \
         enum class _InternalRawEnumToSupportSwitchStatement { _MODERN_ENUM_LIST_ELEMENTS(__VA_ARGS__) }; \
 \
-        constexpr static uint32_t                               s_count { _MODERN_ENUM_COUNT_ELEMENTS(__VA_ARGS__) };\
-        constexpr static std::string_view                       s_name  { #Enum };\
-        constexpr static std::array<std::string_view, s_count>  s_names { _MODERN_ENUM_LIST_NAMES(__VA_ARGS__) };\
+        constexpr static uint32_t                                   s_count     { _MODERN_ENUM_COUNT_ELEMENTS(__VA_ARGS__) };\
+        constexpr static std::string_view                           s_name      { #Enum };\
+        constexpr static std::array<std::string_view, s_count>      s_names     { _MODERN_ENUM_LIST_NAMES(__VA_ARGS__) };\
+        constexpr static internal::modern_enum::NameTable<s_count>  s_nameTable { s_names };\
 \
         _MODERN_ENUM_NATVIS_SUPPORT();\
+        _MODERN_ENUM_REGISTRY_SUPPORT();\
 \
         using EnumArray = std::array<Enum, s_count>;\
         static const EnumArray s_elements;\
@@ -524,17 +1124,50 @@ namespace internal::modern_enum
     constexpr std::string_view       Enum::GetName()  { return s_name; }\
     constexpr const Enum::EnumArray& Enum::GetElements() { return s_elements; }\
 \
-    constexpr Enum Enum::FromString(std::string_view name) { return internal::modern_enum::CreateFromString<s_count>(s_name, name, s_names);} \
-    constexpr Enum Enum::FromIndex(uint32_t index) { return index; } \
+    template <class Policy>\
+    constexpr internal::modern_enum::CheckResult<Policy, Enum> Enum::FromString(std::string_view name)\
+    {\
+        _MODERN_ENUM_START_TIMER(startTime)\
+        const uint32_t idx = internal::modern_enum::CreateFromString<Policy, s_count>(name, s_names);\
+        _MODERN_ENUM_RECORD_FROM_STRING(idx, startTime)\
+        return internal::modern_enum::Check<Policy>(idx < s_count, Enum{idx}, s_name, name);\
+    }\
+\
+    template <class Policy>\
+    constexpr internal::modern_enum::CheckResult<Policy, Enum> Enum::FromIndex(uint32_t index)\
+    {\
+        return internal::modern_enum::Check<Policy>(index < s_count, Enum{index}, s_name, index);\
+    }\
 \
-    constexpr std::string_view Enum::toString() const { return s_names[m_idx.idx]; } \
+    template <class ErrorSink>\
+    uint32_t Enum::ParseColumn(std::string_view buffer, char delimiter, Enum* out, ErrorSink&& onError)\
+    {\
+        uint32_t row = 0;\
+        internal::modern_enum::ForEachToken(buffer, delimiter, [&](std::string_view token) {\
+            const uint32_t idx = s_nameTable.find(token, s_names);\
+            if (idx != internal::modern_enum::s_invalidIndex) out[row] = Enum{idx};\
+            else { out[row] = Enum{}; onError(row, token); }\
+            row++;\
+        });\
+        return row;\
+    }\
+\
+    constexpr std::string_view Enum::toString() const\
+    {\
+        _MODERN_ENUM_RECORD_TO_STRING(m_idx.idx)\
+        return s_names[m_idx.idx];\
+    }\
 \
     constexpr uint32_t Enum::index() const { return m_idx.idx; }\
 \
     constexpr bool Enum::operator == (Enum o) const { return m_idx.idx == o.m_idx.idx; }\
     constexpr bool Enum::operator != (Enum o) const { return !(*this == o); }\
 \
-    constexpr Enum::operator Enum::Set() const { return Set{m_idx.idx}; }\
+    constexpr Enum::operator Enum::Set() const\
+    {\
+        internal::modern_enum::Validate<MODERN_ENUM_DEFAULT_CHECK_POLICY>(m_idx.idx < s_count, s_name, m_idx.idx);\
+        return Set{m_idx.idx};\
+    }\
 \
     constexpr Enum::operator Enum::_InternalRawEnumToSupportSwitchStatement() const { return static_cast<_InternalRawEnumToSupportSwitchStatement>(m_idx.idx); }\
 \
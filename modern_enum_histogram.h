@@ -0,0 +1,189 @@
+﻿#pragma once
+#include "modern_enum.h"
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Histograms over arrays of enum elements. Kept apart from modern_enum.h, so that only their users pay for these includes.
+
+namespace internal::modern_enum
+{
+    constexpr static size_t s_minHistogramElementsPerThread = 1 << 16;
+
+    class JoinThreadsOnExit
+    {
+    public:
+        explicit JoinThreadsOnExit(std::vector<std::thread>& threads) : m_threads{threads} {}
+        ~JoinThreadsOnExit() { join(); }
+
+        JoinThreadsOnExit(const JoinThreadsOnExit&) = delete;
+        JoinThreadsOnExit& operator=(const JoinThreadsOnExit&) = delete;
+
+        void join()
+        {
+            for (std::thread& thread : m_threads)
+                if (thread.joinable())
+                    thread.join();
+        }
+
+    private:
+        std::vector<std::thread>& m_threads;
+    };
+
+    // Counts with several sub-histograms, so that runs of equal values increment different counters
+    // instead of stalling on the store-to-load dependency of a single counter.
+    template <class Enum>
+    void CountWithSubHistograms(const Enum* elements, size_t size, uint64_t* counts)
+    {
+        constexpr uint32_t Count = Enum::GetCount();
+        uint64_t subCounts[4][Count] = {};
+
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4)
+        {
+            subCounts[0][elements[i + 0].index()]++;
+            subCounts[1][elements[i + 1].index()]++;
+            subCounts[2][elements[i + 2].index()]++;
+            subCounts[3][elements[i + 3].index()]++;
+        }
+        for (; i < size; i++)
+            subCounts[0][elements[i].index()]++;
+
+        for (uint32_t v = 0; v < Count; v++)
+            counts[v] += subCounts[0][v] + subCounts[1][v] + subCounts[2][v] + subCounts[3][v];
+    }
+
+#if _MODERN_ENUM_SSE2
+    constexpr static uint32_t s_simdHistogramMaxCount = 16;
+
+    // Expanded at compile time, so that the accumulators can live in registers even without loop unrolling.
+    template <size_t... Values>
+    inline void AccumulateMatches(__m128i* acc, __m128i bytes, std::index_sequence<Values...>)
+    {
+        ((acc[Values] = _mm_sub_epi8(acc[Values], _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(Values))))), ...);
+    }
+
+    // Packs 16 indices into the bytes of a register and compares them against every value at once.
+    // Byte counters are flushed into 64 bit ones before they can overflow.
+    template <class Enum>
+    void CountWithSimd(const Enum* elements, size_t size, uint64_t* counts)
+    {
+        constexpr uint32_t Count = Enum::GetCount();
+        constexpr size_t BlockSize = 16 * 255;
+        static_assert(sizeof(Enum) == sizeof(uint32_t), "Enum is expected to be a plain 32 bit index");
+
+        const __m128i* const data = reinterpret_cast<const __m128i*>(elements);
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        while (size - i >= 16)
+        {
+            const size_t blockEnd = i + std::min(BlockSize, (size - i) / 16 * 16);
+
+            __m128i acc[Count];
+            for (uint32_t v = 0; v < Count; v++)
+                acc[v] = zero;
+
+            for (; i < blockEnd; i += 16)
+            {
+                const __m128i lo = _mm_packs_epi32(_mm_loadu_si128(data + i / 4 + 0), _mm_loadu_si128(data + i / 4 + 1));
+                const __m128i hi = _mm_packs_epi32(_mm_loadu_si128(data + i / 4 + 2), _mm_loadu_si128(data + i / 4 + 3));
+                const __m128i bytes = _mm_packus_epi16(lo, hi);
+                AccumulateMatches(acc, bytes, std::make_index_sequence<Count>{});
+            }
+
+            for (uint32_t v = 0; v < Count; v++)
+            {
+                alignas(16) uint64_t sums[2];
+                _mm_store_si128(reinterpret_cast<__m128i*>(sums), _mm_sad_epu8(acc[v], zero));
+                counts[v] += sums[0] + sums[1];
+            }
+        }
+
+        CountWithSubHistograms(elements + i, size - i, counts);
+    }
+#endif
+}
+
+
+namespace modern_enum
+{
+    // Number of occurrences of each element of an enum, in a dense table indexed by element.
+    template <class Enum>
+    class Histogram
+    {
+    public:
+        constexpr Histogram() : m_counts{} {}
+
+        constexpr uint64_t  operator[] (Enum e) const { return m_counts[e.index()]; }
+        constexpr uint64_t& operator[] (Enum e)       { return m_counts[e.index()]; }
+
+        constexpr uint64_t total() const
+        {
+            uint64_t total = 0;
+            for (uint64_t c : m_counts) total += c;
+            return total;
+        }
+
+        constexpr Histogram& operator += (const Histogram& o)
+        {
+            for (uint32_t i = 0; i < Enum::GetCount(); i++)
+                m_counts[i] += o.m_counts[i];
+            return *this;
+        }
+
+        constexpr uint64_t*       data()       { return m_counts.data(); }
+        constexpr const uint64_t* data() const { return m_counts.data(); }
+
+    private:
+        std::array<uint64_t, Enum::GetCount()> m_counts;
+    };
+
+    template <class Enum>
+    Histogram<Enum> MakeHistogram(const Enum* elements, size_t size)
+    {
+        Histogram<Enum> histogram;
+#if _MODERN_ENUM_SSE2
+        if constexpr (Enum::GetCount() <= internal::modern_enum::s_simdHistogramMaxCount)
+        {
+            internal::modern_enum::CountWithSimd(elements, size, histogram.data());
+            return histogram;
+        }
+#endif
+        internal::modern_enum::CountWithSubHistograms(elements, size, histogram.data());
+        return histogram;
+    }
+
+    // Splits the input in one contiguous range per thread, then merges the per-thread histograms.
+    // At most one thread is used per s_minHistogramElementsPerThread elements.
+    template <class Enum>
+    Histogram<Enum> MakeHistogramParallel(const Enum* elements, size_t size, uint32_t threadCount = std::thread::hardware_concurrency())
+    {
+        // Small inputs are not worth the cost of starting threads.
+        const size_t maxThreadCount = std::max<size_t>(1, size / internal::modern_enum::s_minHistogramElementsPerThread);
+        threadCount = uint32_t(std::clamp<size_t>(threadCount, 1, maxThreadCount));
+        const size_t rangeSize = (size + threadCount - 1) / threadCount;
+
+        std::vector<Histogram<Enum>> histograms(threadCount);
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+
+        // Threads must be joined even if starting one of them throws, or their destruction would call std::terminate.
+        internal::modern_enum::JoinThreadsOnExit joinThreads{ threads };
+
+        for (uint32_t t = 1; t < threadCount; t++)
+        {
+            const size_t begin = std::min(size, t * rangeSize);
+            const size_t end = std::min(size, begin + rangeSize);
+            threads.emplace_back([&, t, begin, end] { histograms[t] = MakeHistogram(elements + begin, end - begin); });
+        }
+        histograms[0] = MakeHistogram(elements, std::min(size, rangeSize));
+
+        joinThreads.join();
+
+        for (uint32_t t = 1; t < threadCount; t++)
+            histograms[0] += histograms[t];
+        return histograms[0];
+    }
+}
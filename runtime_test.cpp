@@ -0,0 +1,310 @@
+﻿#define _CRT_SECURE_NO_WARNINGS
+#include "modern_enum.h"
+#include "modern_enum_histogram.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// This file contains unit tests for the runtime (non-constexpr) parts of the library, which cannot be run at compile time.
+// The executable returns a non-zero exit code if any check fails.
+namespace
+{
+    int s_failureCount = 0;
+}
+
+#define CHECK(Condition) \
+    do { if (!(Condition)) { std::fprintf(stderr, "%s(%d): check failed: %s\n", __FILE__, __LINE__, #Condition); s_failureCount++; } } while (false)
+
+namespace modern_enum::runtime_test
+{
+    MODERN_ENUM(Week, Monday, Tuesday, Wednesday, Thursday, Friday, Saturday, Sunday);
+
+    // Shares its name with modern_enum::test::Color, from test.cpp.
+    MODERN_ENUM(Color, Cyan, Magenta, Yellow);
+
+    // More than 16 elements: counted with sub-histograms rather than SIMD compares.
+    MODERN_ENUM(Letter, A, B, C, D, E, F, G, H, I, J, K, L, M, N, O, P, Q, R, S, T);
+
+    template <class Enum>
+    std::vector<Enum> MakeElements(size_t size)
+    {
+        std::vector<Enum> elements(size);
+        for (size_t i = 0; i < size; i++)
+            elements[i] = Enum::FromIndex(uint32_t((i * i + i / 3) % Enum::GetCount()));
+        return elements;
+    }
+
+    template <class Enum>
+    bool HistogramMatches(const Histogram<Enum>& histogram, const std::vector<Enum>& elements)
+    {
+        Histogram<Enum> expected;
+        for (Enum e : elements) expected[e]++;
+        for (Enum e : Enum::GetElements())
+            if (histogram[e] != expected[e])
+                return false;
+        return histogram.total() == elements.size();
+    }
+
+    // Sizes around the 16 element SIMD step and the 4080 element flush of the byte counters.
+    template <class Enum>
+    void Histogram_RuntimeTest()
+    {
+        for (size_t size : { 0, 1, 15, 16, 17, 4079, 4080, 4081, 8160, 8161, 10000 })
+        {
+            const std::vector<Enum> elements = MakeElements<Enum>(size);
+            CHECK(HistogramMatches(MakeHistogram(elements.data(), elements.size()), elements));
+            CHECK(HistogramMatches(MakeHistogramParallel(elements.data(), elements.size(), 3), elements));
+
+            // A single value, so that every byte counter reaches its maximum before a flush.
+            const std::vector<Enum> repeated(size, Enum::GetElements()[Enum::GetCount() - 1]);
+            CHECK(HistogramMatches(MakeHistogram(repeated.data(), repeated.size()), repeated));
+        }
+
+        // Large enough for MakeHistogramParallel to actually start threads.
+        for (size_t size : { internal::modern_enum::s_minHistogramElementsPerThread * 3, internal::modern_enum::s_minHistogramElementsPerThread * 3 + 1 })
+        {
+            const std::vector<Enum> elements = MakeElements<Enum>(size);
+            CHECK(HistogramMatches(MakeHistogramParallel(elements.data(), elements.size(), 3), elements));
+            CHECK(HistogramMatches(MakeHistogramParallel(elements.data(), elements.size(), 64), elements));
+        }
+
+        // More threads than elements.
+        for (size_t size : { 0, 1, 3, 7 })
+        {
+            const std::vector<Enum> elements = MakeElements<Enum>(size);
+            CHECK(HistogramMatches(MakeHistogramParallel(elements.data(), elements.size(), 8), elements));
+        }
+        CHECK(HistogramMatches(MakeHistogramParallel<Enum>(nullptr, 0, 0), {}));
+    }
+
+    struct ParseResult
+    {
+        std::vector<Week>                                       elements;
+        std::vector<std::pair<uint32_t, std::string_view>>      errors;
+
+        bool operator == (const ParseResult& o) const { return elements == o.elements && errors == o.errors; }
+    };
+
+    ParseResult ParseColumn(std::string_view buffer, char delimiter)
+    {
+        ParseResult result;
+        result.elements.resize(buffer.size() + 1);
+        const uint32_t rows = Week::ParseColumn(buffer, delimiter, result.elements.data(), [&](uint32_t row, std::string_view token) {
+            result.errors.emplace_back(row, token);
+        });
+        result.elements.resize(rows);
+        return result;
+    }
+
+    // Byte-by-byte split, with the same rules as ParseColumn.
+    ParseResult ParseColumnReference(std::string_view buffer, char delimiter)
+    {
+        ParseResult result;
+        size_t begin = 0;
+        while (begin < buffer.size())
+        {
+            const size_t end = std::min(buffer.find(delimiter, begin), buffer.size());
+            const std::string_view token = buffer.substr(begin, end - begin);
+            const std::optional<Week> e = Week::FromString<Checked>(token);
+            if (!e) result.errors.emplace_back(uint32_t(result.elements.size()), token);
+            result.elements.push_back(e.value_or(Week{}));
+            begin = end + 1;
+        }
+        return result;
+    }
+
+    void ParseColumn_RuntimeTest()
+    {
+        CHECK(ParseColumn("", ',') == ParseResult{});
+        CHECK(ParseColumn(",", ',') == (ParseResult{ { Week{} }, { { 0, "" } } }));
+        CHECK(ParseColumn("Sunday", ',') == (ParseResult{ { Week::Sunday }, {} }));
+        CHECK(ParseColumn(",Monday,,Tuesday,", ',') == (ParseResult{ { Week{}, Week::Monday, Week{}, Week::Tuesday }, { { 0, "" }, { 2, "" } } }));
+        CHECK(ParseColumn("Monday\tFunday\tSunday\t", '\t') == (ParseResult{ { Week::Monday, Week{}, Week::Sunday }, { { 1, "Funday" } } }));
+
+        // Every prefix of the buffer puts delimiters and token ends on both sides of 16 byte chunk boundaries,
+        // and exercises the scalar tail with every length from 0 to 15.
+        std::string buffer;
+        for (uint32_t i = 0; i < 40; i++)
+        {
+            buffer += Week::GetElements()[(i * 5) % Week::GetCount()].toString();
+            buffer += (i % 7 == 3) ? ";;" : ";";
+        }
+        for (size_t size = 0; size <= buffer.size(); size++)
+        {
+            const std::string_view prefix = std::string_view(buffer).substr(0, size);
+            CHECK(ParseColumn(prefix, ';') == ParseColumnReference(prefix, ';'));
+        }
+    }
+
+    // Trapping aborts the process, so each case runs in a child process: the executable calls itself with --trap <case>.
+    int RunTrapCase(std::string_view trapCase)
+    {
+        if (trapCase == "FromString") Week::FromString<Trapping>("Funday");
+        if (trapCase == "FromIndex") Week::FromIndex<Trapping>(7);
+        return 0;
+    }
+
+    std::string RunTrapCaseInChildProcess(const char* executable, const char* trapCase, int& exitCode)
+    {
+        const char* outputFile = "runtime_test_trap_output.txt";
+        const std::string command = std::string("\"") + executable + "\" --trap " + trapCase + " 2> " + outputFile;
+        exitCode = std::system(command.c_str());
+
+        std::ifstream file{ outputFile };
+        const std::string output{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        file.close();
+        std::remove(outputFile);
+        return output;
+    }
+
+    void TrappingPolicy_RuntimeTest(const char* executable)
+    {
+        int exitCode = 0;
+
+        std::string output = RunTrapCaseInChildProcess(executable, "FromString", exitCode);
+        CHECK(exitCode != 0);
+        CHECK(output.find("Week") != std::string::npos);
+        CHECK(output.find("Funday") != std::string::npos);
+
+        output = RunTrapCaseInChildProcess(executable, "FromIndex", exitCode);
+        CHECK(exitCode != 0);
+        CHECK(output.find("Week") != std::string::npos);
+        CHECK(output.find("index 7") != std::string::npos);
+
+        output = RunTrapCaseInChildProcess(executable, "None", exitCode);
+        CHECK(exitCode == 0);
+        CHECK(output.empty());
+    }
+
+    MODERN_ENUM(Instrumented, First, Second, Third);
+
+    std::string DumpToString()
+    {
+        const char* outputFile = "runtime_test_dump_output.txt";
+        if (std::FILE* file = std::fopen(outputFile, "w"))
+        {
+            Instrumentation::Dump(file);
+            std::fclose(file);
+        }
+
+        std::ifstream file{ outputFile };
+        const std::string output{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        file.close();
+        std::remove(outputFile);
+        return output;
+    }
+
+    void Instrumentation_RuntimeTest()
+    {
+        for (uint32_t i = 0; i < 2; i++) CHECK(Instrumented::Second.toString() == "Second");
+        CHECK(Instrumented::FromString("Third") == Instrumented::Third);
+
+        // Counters of threads that have exited are kept in the retired totals.
+        std::thread{ [] { CHECK(Instrumented::FromString("Third") == Instrumented::Third); } }.join();
+        std::thread{ [] { CHECK(Instrumented::FromString<Checked>("Fourth") == std::nullopt); } }.join();
+
+        // Counters of live threads are read from their buffers.
+        std::promise<void> counted, dumped;
+        std::thread thread{ [&] {
+            CHECK(Instrumented::Second.toString() == "Second");
+            counted.set_value();
+            dumped.get_future().wait();
+        } };
+        counted.get_future().wait();
+
+        const std::string output = DumpToString();
+        dumped.set_value();
+        thread.join();
+#if MODERN_ENUM_INSTRUMENTATION_ENABLED
+        const size_t begin = output.find("Instrumented: toString 3, FromString 3 (1 misses)\n");
+        CHECK(begin != std::string::npos);
+        if (begin == std::string::npos) return;
+
+        // The enum's report goes on until the next unindented line.
+        size_t end = begin;
+        do end = output.find('\n', end + 1);
+        while (end != std::string::npos && end + 1 < output.size() && output[end + 1] == ' ');
+        const std::string report = output.substr(begin, end - begin + 1);
+
+        CHECK(report.find("    Second: toString 3, FromString 0\n") != std::string::npos);
+        CHECK(report.find("    Third: toString 0, FromString 2\n") != std::string::npos);
+        CHECK(report.find("First") == std::string::npos);
+        CHECK(report.find("    FromString latency < ") != std::string::npos);
+#else
+        CHECK(output.empty());
+#endif
+    }
+
+#if MODERN_ENUM_REGISTRY_ENABLED
+    template <class Func>
+    bool RegistryContains(Func&& predicate)
+    {
+        bool found = false;
+        Registry::ForEach([&](const EnumInfo& info) { found |= predicate(info); });
+        return found;
+    }
+#endif
+
+    void Registry_RuntimeTest()
+    {
+#if MODERN_ENUM_REGISTRY_ENABLED
+        const EnumInfo* week = Registry::Find("Week");
+        CHECK(week != nullptr);
+        CHECK(week && week->name() == "Week");
+        CHECK(week && week->count() == Week::GetCount());
+        CHECK(week && week->elementName(4) == "Friday");
+        CHECK(week && week->findIndex("Sunday") == 6u);
+        CHECK(week && !week->ambiguous());
+
+        CHECK(Registry::FindIndex("Week", "Friday") == 4u);
+        CHECK(Registry::FindIndex("LongEnum", "e198") == 198u);
+
+        CHECK(Registry::Find("Month") == nullptr);
+        CHECK(Registry::Find("") == nullptr);
+        CHECK(Registry::FindIndex("Month", "Monday") == std::nullopt);
+        CHECK(Registry::FindIndex("Week", "Funday") == std::nullopt);
+        CHECK(Registry::FindIndex("Week", "") == std::nullopt);
+
+        CHECK(Registry::Find("Color") == nullptr);
+        CHECK(Registry::FindIndex("Color", "Cyan") == std::nullopt);
+
+        for (std::string_view name : { "Week", "Color", "ShortEnum", "LongEnum" })
+            CHECK(RegistryContains([&](const EnumInfo& info) { return info.name() == name; }));
+
+        uint32_t colorCount = 0;
+        Registry::ForEach([&](const EnumInfo& info) {
+            if (info.name() != "Color") return;
+            colorCount++;
+            CHECK(info.ambiguous());
+        });
+        CHECK(colorCount == 2);
+#endif
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace modern_enum::runtime_test;
+
+    if (argc == 3 && std::string_view(argv[1]) == "--trap")
+        return RunTrapCase(argv[2]);
+
+    Registry_RuntimeTest();
+    ParseColumn_RuntimeTest();
+    Histogram_RuntimeTest<Week>();
+    Histogram_RuntimeTest<Letter>();
+    TrappingPolicy_RuntimeTest(argv[0]);
+    Instrumentation_RuntimeTest();
+
+    if (s_failureCount == 0)
+        std::printf("All runtime tests passed.\n");
+    return s_failureCount == 0 ? 0 : 1;
+}
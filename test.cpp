@@ -1,4 +1,5 @@
 ﻿#include "modern_enum.h"
+#include "modern_enum_histogram.h"
 
 // This files contains unit tests for the modern enum library.
 // The library is fully constexpr, so all unit tests can be run at compile time.
@@ -83,6 +84,39 @@ namespace modern_enum::test
         static_assert(Color::Green == Color::FromIndex(1));
     }
 
+    void UncheckedPolicy_CompileTimeTest()
+    {
+        static_assert(Color::FromString<modern_enum::Unchecked>("Blue") == Color::Blue);
+        static_assert(Color::FromIndex<modern_enum::Unchecked>(2) == Color::Blue);
+    }
+
+    void CheckedPolicy_CompileTimeTest()
+    {
+        static_assert(Color::FromString<modern_enum::Checked>("Blue") == Color::Blue);
+        static_assert(Color::FromString<modern_enum::Checked>("Purple") == std::nullopt);
+        static_assert(Color::FromString<modern_enum::Checked>("") == std::nullopt);
+        static_assert(Color::FromIndex<modern_enum::Checked>(2) == Color::Blue);
+        static_assert(Color::FromIndex<modern_enum::Checked>(3) == std::nullopt);
+    }
+
+    void TrappingPolicy_CompileTimeTest()
+    {
+        static_assert(Color::FromString<modern_enum::Trapping>("Blue") == Color::Blue);
+        static_assert(Color::FromIndex<modern_enum::Trapping>(2) == Color::Blue);
+        static_assert(std::is_same_v<decltype(Color::FromIndex<modern_enum::Trapping>(0)), Color>);
+    }
+
+    void NameTable_CompileTimeTest()
+    {
+        constexpr std::array<std::string_view, 3> names { "Red", "Green", "Blue" };
+        constexpr internal::modern_enum::NameTable<3> table { names };
+        static_assert(table.slotCount() == 8);
+        static_assert(table.find("Red", names) == 0);
+        static_assert(table.find("Blue", names) == 2);
+        static_assert(table.find("Purple", names) == internal::modern_enum::s_invalidIndex);
+        static_assert(table.find("", names) == internal::modern_enum::s_invalidIndex);
+    }
+
     void Switch_CompileTimeTest()
     {
         switch (red)
@@ -127,9 +161,27 @@ namespace modern_enum::test
         static_assert(e63_64_65.count() == 3);
         static_assert((~e63_64_65).count() == 196);
         static_assert(e63_64_65.contains(LongEnum::e063 | LongEnum::e065) );
+        static_assert(LongEnum::FromIndex<modern_enum::Checked>(198) == LongEnum::e198);
+        static_assert(LongEnum::FromIndex<modern_enum::Checked>(199) == std::nullopt);
 
     }
 
+    constexpr bool LongEnumNameTableFindsAllElements()
+    {
+        std::array<std::string_view, LongEnum::GetCount()> names{};
+        for (LongEnum e : LongEnum::GetElements()) names[e.index()] = e.toString();
+        internal::modern_enum::NameTable<LongEnum::GetCount()> table{ names };
+        for (LongEnum e : LongEnum::GetElements())
+            if (table.find(e.toString(), names) != e.index())
+                return false;
+        return table.find("e199", names) == internal::modern_enum::s_invalidIndex;
+    }
+
+    void LongEnumNameTable_CompileTimeTest()
+    {
+        static_assert(LongEnumNameTableFindsAllElements());
+    }
+
     constexpr Color::Set makeBlueWithBitwiseAnd() {
         Color::Set c = magentaSet;
         c &= Color::Blue;
@@ -146,6 +198,26 @@ namespace modern_enum::test
         return c;
     }
 
+    constexpr modern_enum::Histogram<Color> makeHistogram() {
+        modern_enum::Histogram<Color> h;
+        h[Color::Red] += 2;
+        h[Color::Blue]++;
+        modern_enum::Histogram<Color> other;
+        other[Color::Blue] = 3;
+        h += other;
+        return h;
+    }
+
+    void Histogram_CompileTimeTest()
+    {
+        constexpr auto h = makeHistogram();
+        static_assert(h[Color::Red] == 2);
+        static_assert(h[Color::Green] == 0);
+        static_assert(h[Color::Blue] == 4);
+        static_assert(h.total() == 6);
+        static_assert(modern_enum::Histogram<LongEnum>{}.total() == 0);
+    }
+
     void BitwiseOperators_CompileTimeTest()
     {
         static_assert(makeBlueWithBitwiseAnd() == Color::Blue);